@@ -6,8 +6,11 @@
 #include <optional>
 #include <iostream>
 #include <cstdlib>
+#include <cctype>
 #include <vector>
 #include <limits>
+#include <chrono>
+#include <string>
 #include <map>
 #include <set>
 
@@ -30,11 +33,11 @@ private:
 
 	//GLFW Variables
 
-	GLFWwindow* window; 
-
 	const uint32_t WIDTH = 800; 
 	const uint32_t HEIGHT = 600; 
 
+	uint32_t viewCount; 
+
 	//Vk Variables
 
 	VkInstance instance; 
@@ -43,11 +46,7 @@ private:
 		VkDebugUtilsMessengerEXT debugMessenger; 
 			//Vk Validation Layers 
 			const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" }; 
-			#ifdef  NDEBUG
-				const bool enabelValidationLayer = true; 
-			#else
-				const bool enableValidationLayer = true; 
-			#endif //  NDEBUG
+			const bool enableValidationLayer; 
 
 		//Phiyiscal Device
 		VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE; 
@@ -62,7 +61,6 @@ private:
 		};
 
 		//Window Variables 
-		VkSurfaceKHR surface; 
 		VkQueue presentQueue; 
 
 		//Logical device Variables 
@@ -70,6 +68,15 @@ private:
 	
 			//Device Queues
 			VkQueue graphicsQueue;
+			QueueFamilyIndices deviceQueueFamilies; 
+
+		//Command Pool, shared by every view 
+		VkCommandPool commandPool; 
+
+		//Frame Sync 
+		static const uint32_t MAX_FRAMES_IN_FLIGHT = 2; 
+		std::vector<VkFence> inFlightFences; 
+		uint32_t currentFrame = 0; 
 
 		//Swap Chain 
 		struct SwapChainSupportDetails {
@@ -82,32 +89,62 @@ private:
 			}
 		};
 
-		VkFormat swapChainImageFormat; 
-		VkExtent2D swapChainExtent; 
+		//View, one per window. Instance, device, queues and command pool are shared between all views 
+		struct View {
+			GLFWwindow* window = nullptr; 
+			VkSurfaceKHR surface = VK_NULL_HANDLE; 
+			VkClearColorValue clearColor{}; 
+
+			VkFormat swapChainImageFormat; 
+			VkExtent2D swapChainExtent; 
+			VkPresentModeKHR presentMode; 
 
-		VkSwapchainKHR swapChain;
+			VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+			bool swapChainOutOfDate = false;	//rebuilt before the next acquire, once the surface is not 0x0
 
-			//Swap chain Images 
-			std::vector<VkImage> swapChainImages; 
+				//Swap chain Images 
+				std::vector<VkImage> swapChainImages; 
+
+			//Image views 
+			std::vector<VkImageView> swapChainImageViews; 
+
+			//Command buffers, one per swap chain image, recorded once 
+			std::vector<VkCommandBuffer> commandBuffers; 
+
+			//Frame Sync 
+			std::vector<VkSemaphore> imageAvailableSemaphores;	//per frame in flight
+			std::vector<VkSemaphore> renderFinishedSemaphores;	//per swap chain image
+			std::vector<VkFence> imagesInFlight;				//per swap chain image
+		};
 
-		//Image views 
-		std::vector<VkImageView> swapChainImageViews; 
+		std::vector<View> views; 
+
+		//Submit and present lists, cleared every frame but kept as members so drawing a frame does not allocate
+		std::vector<VkSemaphore> waitSemaphores; 
+		std::vector<VkPipelineStageFlags> waitStages; 
+		std::vector<VkCommandBuffer> frameCommandBuffers; 
+		std::vector<VkSemaphore> signalSemaphores; 
+		std::vector<VkSwapchainKHR> swapChains; 
+		std::vector<uint32_t> imageIndices; 
+		std::vector<View*> presentViews; 
+		std::vector<VkResult> presentResults; 
 
 private: 
 	//GLFW functions
 	void initWindow(); 
+	void createWindow(View& view, uint32_t index); 
 
 	//Vk functions
 	void initVulkan();
 	void setupDebugMessenger(); 
 
 		//Window Functions 
-		void createSurface(); 
+		void createSurface(View& view); 
 
 		//Physical Device Functions	
 		void pickPhysicalDevice(); 
 		int ratePhysicalDevice(VkPhysicalDevice device); 
-		QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) {
+		QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface) {
 			QueueFamilyIndices indices; 
 
 			uint32_t queueFamilyCount = 0; 
@@ -136,7 +173,7 @@ private:
 		}
 
 		//SwapChain functions 
-		SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) {
+		SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface) {
 			SwapChainSupportDetails details; 
 
 			vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilites); 
@@ -160,15 +197,28 @@ private:
 			return details; 
 		}
 
+		//Present modes in order of preference, FIFO is the fallback as it is always available
+		const std::vector<VkPresentModeKHR> presentModePreference; 
+
 		VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> availableFormats); 
 		VkPresentModeKHR choosePresnetMode(const std::vector<VkPresentModeKHR> availableModes); 
-		VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilites); 
+		static const char* presentModeName(VkPresentModeKHR mode); 
+		VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilites, GLFWwindow* window); 
 
-		void getSwapChainImages(); 
+		void getSwapChainImages(View& view); 
+		void cleanupSwapChain(View& view); 
+		void recreateSwapChain(View& view); 
+		bool hasDrawableExtent(View& view); 
 
 
 		//Image View functions
-		void DestroyImageViews(); 
+		void DestroyImageViews(View& view); 
+
+		//View functions 
+		void addView(); 
+		void reserveFrameLists(); 
+		void createViewResources(View& view); 
+		void destroyView(View& view); 
 		
 
 
@@ -177,8 +227,13 @@ private:
 	void createInfo(VkApplicationInfo& appInfo); 
 	void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createDebugInfo); 
 	void createLogicalDevice(); 
-	void createSwapChain();
-	void createImageViews(); 
+	void createSwapChain(View& view);
+	void createImageViews(View& view); 
+	void createCommandPool(); 
+	void createCommandBuffers(View& view); 
+	void createSyncObjects(); 
+	void createViewSyncObjects(View& view); 
+	void createSwapChainSyncObjects(View& view); 
 
 	//Check functions
 	std::vector<const char*> getRequierdExtensions(); 
@@ -191,17 +246,24 @@ private:
 	//Debug Message functions
 	static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT MessageSeverity, VkDebugUtilsMessageTypeFlagBitsEXT MessageType, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData); 
 
+	uint32_t drawFrame(); 
 	void mainloop(); 
 	void cleanup(); 
 
 public: 
 
+	HelloTriangleApp(uint32_t viewCount = 1, bool enableValidationLayer = true, std::vector<VkPresentModeKHR> presentModePreference = { VK_PRESENT_MODE_MAILBOX_KHR })
+		: viewCount(viewCount), enableValidationLayer(enableValidationLayer), presentModePreference(presentModePreference) {}
+
 	void run() {
 		initWindow(); 
 		initVulkan(); 
 		mainloop(); 
 		cleanup(); 
 	}
+
+	//Renders viewCount..maxViews views, adding one window at a time, and prints the average frame time for each count
+	void benchmark(uint32_t maxViews, uint32_t frameCount); 
 };
 
 //Initaliazation Functions
@@ -212,17 +274,48 @@ void HelloTriangleApp::initWindow() {
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); 
 	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE); 
 
-	window = glfwCreateWindow(WIDTH, HEIGHT, "Vulkan Triangle", nullptr, nullptr); 
+	views.resize(viewCount); 
+	for (uint32_t it = 0; it < viewCount; it++) createWindow(views[it], it); 
+}
+
+void HelloTriangleApp::createWindow(View& view, uint32_t index) {
+	std::string title = "Vulkan Triangle"; 
+	if (index > 0) title += " (View " + std::to_string(index) + ")"; 
+
+	view.window = glfwCreateWindow(WIDTH, HEIGHT, title.c_str(), nullptr, nullptr); 
+	if (view.window == nullptr) throw std::runtime_error("Failed to create window!"); 
+
+	//View i goes to monitor i when there is one, the remaining views are stepped across the primary monitor
+	int monitorCount = 0; 
+	GLFWmonitor** monitors = glfwGetMonitors(&monitorCount); 
+
+	if (index < static_cast<uint32_t>(monitorCount)) {
+		int x, y, width, height; 
+		glfwGetMonitorWorkarea(monitors[index], &x, &y, &width, &height); 
+		glfwSetWindowPos(view.window, x + std::max(0, (width - static_cast<int>(WIDTH)) / 2), y + std::max(0, (height - static_cast<int>(HEIGHT)) / 2)); 
+	}
+	else glfwSetWindowPos(view.window, 40 * (index + 1), 40 * (index + 1)); 
+
+	//Give every view its own clear color so the displays can be told apart
+	const VkClearColorValue colors[] = {
+		{ { 0.10f, 0.10f, 0.40f, 1.0f } },
+		{ { 0.40f, 0.10f, 0.10f, 1.0f } },
+		{ { 0.10f, 0.40f, 0.10f, 1.0f } },
+		{ { 0.40f, 0.40f, 0.10f, 1.0f } },
+	};
+	view.clearColor = colors[index % (sizeof(colors) / sizeof(colors[0]))]; 
 }
 
 void HelloTriangleApp::initVulkan() {
 	createInstance(); 
 	setupDebugMessenger();
-	createSurface(); 
+	for (auto& view : views) createSurface(view); 
 	pickPhysicalDevice();
 	createLogicalDevice(); 
-	createSwapChain(); 
-	createImageViews(); 
+	createCommandPool(); 
+	createSyncObjects(); 
+	for (auto& view : views) createViewResources(view); 
+	reserveFrameLists(); 
 }
 
 void HelloTriangleApp::setupDebugMessenger() {
@@ -235,8 +328,8 @@ void HelloTriangleApp::setupDebugMessenger() {
 }
 
 //Window Functions 
-void HelloTriangleApp::createSurface(){
-	if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) throw std::runtime_error("Failed to create window surface!"); 
+void HelloTriangleApp::createSurface(View& view){
+	if (glfwCreateWindowSurface(instance, view.window, nullptr, &view.surface) != VK_SUCCESS) throw std::runtime_error("Failed to create window surface!"); 
 }
 
 //Physical Device Functions 
@@ -274,7 +367,7 @@ int HelloTriangleApp::ratePhysicalDevice(VkPhysicalDevice device) {
 	vkGetPhysicalDeviceProperties(device, &deviceProperties);
 	vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
 
-	QueueFamilyIndices indices = findQueueFamilies(device); 
+	QueueFamilyIndices indices = findQueueFamilies(device, views.front().surface); 
 
 	if (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) score += 1000; 
 
@@ -294,14 +387,26 @@ VkSurfaceFormatKHR HelloTriangleApp::chooseSwapSurfaceFormat(const std::vector<V
 }
 
 VkPresentModeKHR HelloTriangleApp::choosePresnetMode(const std::vector<VkPresentModeKHR> availableModes){
-	for (const auto& availableMode : availableModes) {
-		if (availableMode == VK_PRESENT_MODE_MAILBOX_KHR) return availableMode; 
+	for (const auto& preferredMode : presentModePreference) {
+		for (const auto& availableMode : availableModes) {
+			if (availableMode == preferredMode) return availableMode; 
+		}
 	}
 
 	return VK_PRESENT_MODE_FIFO_KHR; 
 }
 
-VkExtent2D HelloTriangleApp::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilites){
+const char* HelloTriangleApp::presentModeName(VkPresentModeKHR mode) {
+	switch (mode) {
+	case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE"; 
+	case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX"; 
+	case VK_PRESENT_MODE_FIFO_KHR: return "FIFO"; 
+	case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED"; 
+	default: return "UNKNOWN"; 
+	}
+}
+
+VkExtent2D HelloTriangleApp::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilites, GLFWwindow* window){
 	if (capabilites.currentExtent.width != std::numeric_limits<uint32_t>::max()) return capabilites.currentExtent; 
 	else {
 		int width, height; 
@@ -316,20 +421,101 @@ VkExtent2D HelloTriangleApp::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& ca
 	}
 }
 
-void HelloTriangleApp::getSwapChainImages(){
+void HelloTriangleApp::getSwapChainImages(View& view){
 	uint32_t imageCount; 
-	vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr); 
+	vkGetSwapchainImagesKHR(device, view.swapChain, &imageCount, nullptr); 
 	
-	swapChainImages.resize(imageCount); 
-	vkGetSwapchainImagesKHR(device, swapChain, &imageCount, swapChainImages.data()); 
+	view.swapChainImages.resize(imageCount); 
+	vkGetSwapchainImagesKHR(device, view.swapChain, &imageCount, view.swapChainImages.data()); 
 
 }
 
+void HelloTriangleApp::cleanupSwapChain(View& view) {
+	vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(view.commandBuffers.size()), view.commandBuffers.data()); 
+	view.commandBuffers.clear(); 
+
+	for (auto semaphore : view.renderFinishedSemaphores) {
+		vkDestroySemaphore(device, semaphore, nullptr); 
+	}
+	view.renderFinishedSemaphores.clear(); 
+	view.imagesInFlight.clear(); 
+
+	DestroyImageViews(view); 
+	vkDestroySwapchainKHR(device, view.swapChain, nullptr); 
+	view.swapChain = VK_NULL_HANDLE; 
+}
+
+void HelloTriangleApp::recreateSwapChain(View& view) {
+	vkDeviceWaitIdle(device); 
+
+	cleanupSwapChain(view); 
+
+	createSwapChain(view); 
+	createImageViews(view); 
+	createCommandBuffers(view); 
+	createSwapChainSyncObjects(view); 
+}
+
+bool HelloTriangleApp::hasDrawableExtent(View& view) {
+	VkSurfaceCapabilitiesKHR capabilites; 
+	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(PhysicalDevice, view.surface, &capabilites); 
+
+	if (capabilites.currentExtent.width != std::numeric_limits<uint32_t>::max()) return capabilites.currentExtent.width > 0 && capabilites.currentExtent.height > 0; 
+
+	int width, height; 
+	glfwGetFramebufferSize(view.window, &width, &height); 
+	return width > 0 && height > 0; 
+}
+
 //Image View functions 
-void HelloTriangleApp::DestroyImageViews(){
-	for (auto imageView : swapChainImageViews) {
+void HelloTriangleApp::DestroyImageViews(View& view){
+	for (auto imageView : view.swapChainImageViews) {
 		vkDestroyImageView(device, imageView, nullptr); 
 	}
+	view.swapChainImageViews.clear(); 
+}
+
+//View functions 
+void HelloTriangleApp::addView() {
+	views.emplace_back(); 
+	View& view = views.back(); 
+
+	createWindow(view, static_cast<uint32_t>(views.size() - 1)); 
+	createSurface(view); 
+	createViewResources(view); 
+
+	reserveFrameLists(); 
+}
+
+void HelloTriangleApp::reserveFrameLists() {
+	waitSemaphores.reserve(views.size()); 
+	waitStages.reserve(views.size()); 
+	frameCommandBuffers.reserve(views.size()); 
+	signalSemaphores.reserve(views.size()); 
+	swapChains.reserve(views.size()); 
+	imageIndices.reserve(views.size()); 
+	presentViews.reserve(views.size()); 
+	presentResults.reserve(views.size()); 
+}
+
+void HelloTriangleApp::createViewResources(View& view) {
+	createSwapChain(view); 
+	createImageViews(view); 
+	createCommandBuffers(view); 
+	createSwapChainSyncObjects(view); 
+	createViewSyncObjects(view); 
+}
+
+void HelloTriangleApp::destroyView(View& view) {
+	cleanupSwapChain(view); 
+
+	for (auto semaphore : view.imageAvailableSemaphores) {
+		vkDestroySemaphore(device, semaphore, nullptr); 
+	}
+	view.imageAvailableSemaphores.clear(); 
+
+	vkDestroySurfaceKHR(instance, view.surface, nullptr); 
+	glfwDestroyWindow(view.window); 
 }
 
 
@@ -415,7 +601,7 @@ void HelloTriangleApp::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCre
 }
 
 void HelloTriangleApp::createLogicalDevice() {
-	QueueFamilyIndices indices = findQueueFamilies(PhysicalDevice);
+	QueueFamilyIndices indices = findQueueFamilies(PhysicalDevice, views.front().surface);
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos; 
 	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentationFamily.value() }; 
 	
@@ -453,14 +639,23 @@ void HelloTriangleApp::createLogicalDevice() {
 
 	vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue); 
 	vkGetDeviceQueue(device, indices.presentationFamily.value(), 0, &presentQueue); 
+
+	deviceQueueFamilies = indices; 
 }
 
-void HelloTriangleApp::createSwapChain() {
-	SwapChainSupportDetails swapChainSupport = querySwapChainSupport(PhysicalDevice);
+void HelloTriangleApp::createSwapChain(View& view) {
+	//Every view presents through the shared present queue, so its surface has to support that family
+	VkBool32 presentSupport = false; 
+	vkGetPhysicalDeviceSurfaceSupportKHR(PhysicalDevice, deviceQueueFamilies.presentationFamily.value(), view.surface, &presentSupport); 
+	if (!presentSupport) throw std::runtime_error("Present queue does not support the view's surface!"); 
+
+	SwapChainSupportDetails swapChainSupport = querySwapChainSupport(PhysicalDevice, view.surface);
+
+	if (!(swapChainSupport.capabilites.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)) throw std::runtime_error("Swapchain images can not be cleared!"); 
 
 	VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats); 
 	VkPresentModeKHR presentMode = choosePresnetMode(swapChainSupport.presentModes); 
-	VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilites); 
+	VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilites, view.window); 
 
 	uint32_t imageCount = swapChainSupport.capabilites.minImageCount + 1; 
 
@@ -468,15 +663,15 @@ void HelloTriangleApp::createSwapChain() {
 
 	VkSwapchainCreateInfoKHR createInfo{}; 
 	createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR; 
-	createInfo.surface = surface; 
+	createInfo.surface = view.surface; 
 	createInfo.minImageCount = imageCount; 
 	createInfo.imageFormat = surfaceFormat.format; 
 	createInfo.imageColorSpace = surfaceFormat.colorSpace; 
 	createInfo.imageExtent = extent; 
 	createInfo.imageArrayLayers = 1; 
-	createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; 
+	createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT; 
 
-	QueueFamilyIndices indices = findQueueFamilies(PhysicalDevice); 
+	QueueFamilyIndices indices = deviceQueueFamilies; 
 
 	uint32_t queueFamilyIndices[] = { indices.graphicsFamily.value(), indices.presentationFamily.value() }; 
 
@@ -498,23 +693,24 @@ void HelloTriangleApp::createSwapChain() {
 	createInfo.oldSwapchain = VK_NULL_HANDLE; 
 
 
-	if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS) throw std::runtime_error("failed to create Swapchain!"); 
+	if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &view.swapChain) != VK_SUCCESS) throw std::runtime_error("failed to create Swapchain!"); 
 
-	swapChainExtent = extent; 
-	swapChainImageFormat = surfaceFormat.format; 
+	view.swapChainExtent = extent; 
+	view.swapChainImageFormat = surfaceFormat.format; 
+	view.presentMode = presentMode; 
 
-	getSwapChainImages(); 
+	getSwapChainImages(view); 
 }
 
-void HelloTriangleApp::createImageViews() {
-	swapChainImageViews.resize(swapChainImages.size()); 
+void HelloTriangleApp::createImageViews(View& view) {
+	view.swapChainImageViews.resize(view.swapChainImages.size()); 
 
-	for (size_t it = 0; it < swapChainImages.size(); it++) {
+	for (size_t it = 0; it < view.swapChainImages.size(); it++) {
 		VkImageViewCreateInfo createInfo{}; 
 		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO; 
-		createInfo.image = swapChainImages[it]; 
+		createInfo.image = view.swapChainImages[it]; 
 		createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D; 
-		createInfo.format = swapChainImageFormat; 
+		createInfo.format = view.swapChainImageFormat; 
 
 		createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY; 
 		createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY; 
@@ -527,7 +723,101 @@ void HelloTriangleApp::createImageViews() {
 		createInfo.subresourceRange.baseArrayLayer = 0; 
 		createInfo.subresourceRange.layerCount = 1; 
 
-		if (vkCreateImageView(device, &createInfo, nullptr, &swapChainImageViews[it]) != VK_SUCCESS) throw std::runtime_error("failed to create Image View!"); 
+		if (vkCreateImageView(device, &createInfo, nullptr, &view.swapChainImageViews[it]) != VK_SUCCESS) throw std::runtime_error("failed to create Image View!"); 
+	}
+}
+
+void HelloTriangleApp::createCommandPool() {
+	VkCommandPoolCreateInfo poolInfo{}; 
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO; 
+	poolInfo.queueFamilyIndex = deviceQueueFamilies.graphicsFamily.value(); 
+
+	if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) throw std::runtime_error("failed to create Command Pool!"); 
+}
+
+void HelloTriangleApp::createCommandBuffers(View& view) {
+	view.commandBuffers.resize(view.swapChainImages.size()); 
+
+	VkCommandBufferAllocateInfo allocInfo{}; 
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO; 
+	allocInfo.commandPool = commandPool; 
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; 
+	allocInfo.commandBufferCount = static_cast<uint32_t>(view.commandBuffers.size()); 
+
+	if (vkAllocateCommandBuffers(device, &allocInfo, view.commandBuffers.data()) != VK_SUCCESS) throw std::runtime_error("failed to allocate Command Buffers!"); 
+
+	//The content of a view does not change between frames, so every image's commands are recorded once here
+	for (size_t it = 0; it < view.commandBuffers.size(); it++) {
+		VkCommandBufferBeginInfo beginInfo{}; 
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO; 
+
+		if (vkBeginCommandBuffer(view.commandBuffers[it], &beginInfo) != VK_SUCCESS) throw std::runtime_error("failed to begin recording Command Buffer!"); 
+
+		VkImageSubresourceRange range{}; 
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT; 
+		range.baseMipLevel = 0; 
+		range.levelCount = 1; 
+		range.baseArrayLayer = 0; 
+		range.layerCount = 1; 
+
+		VkImageMemoryBarrier barrier{}; 
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER; 
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; 
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; 
+		barrier.image = view.swapChainImages[it]; 
+		barrier.subresourceRange = range; 
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; 
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; 
+		barrier.srcAccessMask = 0; 
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; 
+		vkCmdPipelineBarrier(view.commandBuffers[it], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier); 
+
+		vkCmdClearColorImage(view.commandBuffers[it], view.swapChainImages[it], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &view.clearColor, 1, &range); 
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; 
+		barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; 
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; 
+		barrier.dstAccessMask = 0; 
+		vkCmdPipelineBarrier(view.commandBuffers[it], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier); 
+
+		if (vkEndCommandBuffer(view.commandBuffers[it]) != VK_SUCCESS) throw std::runtime_error("failed to record Command Buffer!"); 
+	}
+}
+
+void HelloTriangleApp::createSyncObjects() {
+	inFlightFences.resize(MAX_FRAMES_IN_FLIGHT); 
+
+	VkFenceCreateInfo fenceInfo{}; 
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO; 
+	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; 
+
+	for (uint32_t it = 0; it < MAX_FRAMES_IN_FLIGHT; it++) {
+		if (vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[it]) != VK_SUCCESS) throw std::runtime_error("failed to create Fence!"); 
+	}
+}
+
+void HelloTriangleApp::createViewSyncObjects(View& view) {
+	view.imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT); 
+
+	VkSemaphoreCreateInfo semaphoreInfo{}; 
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO; 
+
+	for (uint32_t it = 0; it < MAX_FRAMES_IN_FLIGHT; it++) {
+		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &view.imageAvailableSemaphores[it]) != VK_SUCCESS) throw std::runtime_error("failed to create Semaphore!"); 
+	}
+}
+
+void HelloTriangleApp::createSwapChainSyncObjects(View& view) {
+	//Render finished semaphores are per image, a present may still hold the one of the previous frame
+	view.renderFinishedSemaphores.resize(view.swapChainImages.size()); 
+	view.imagesInFlight.assign(view.swapChainImages.size(), VK_NULL_HANDLE); 
+
+	VkSemaphoreCreateInfo semaphoreInfo{}; 
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO; 
+
+	for (size_t it = 0; it < view.renderFinishedSemaphores.size(); it++) {
+		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &view.renderFinishedSemaphores[it]) != VK_SUCCESS) throw std::runtime_error("failed to create Semaphore!"); 
 	}
 }
 
@@ -564,13 +854,13 @@ bool HelloTriangleApp::validValidationLayerSupport() {
 }
 
 bool HelloTriangleApp::isDeviceSuitable(VkPhysicalDevice device) {
-	QueueFamilyIndices indicies = findQueueFamilies(device); 
+	QueueFamilyIndices indicies = findQueueFamilies(device, views.front().surface); 
 
 	bool deviceExtensionSupported = checkDeviceExtensionsSupport(device); 
 
 	bool swapChainAdequate = false;
 	if (deviceExtensionSupported) {
-		SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device); 
+		SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device, views.front().surface); 
 		swapChainAdequate = swapChainSupport.isChainAdequate(); 
 	}
 	return indicies.isComplete() && deviceExtensionSupported && swapChainAdequate; 
@@ -615,33 +905,238 @@ VKAPI_ATTR VkBool32 VKAPI_CALL HelloTriangleApp::debugCallback(VkDebugUtilsMessa
 
 //Main loop 
 
+//Returns the number of views presented this frame
+uint32_t HelloTriangleApp::drawFrame() {
+	vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX); 
+
+	waitSemaphores.clear(); 
+	waitStages.clear(); 
+	frameCommandBuffers.clear(); 
+	signalSemaphores.clear(); 
+	swapChains.clear(); 
+	imageIndices.clear(); 
+	presentViews.clear(); 
+
+	for (auto& view : views) {
+		//A minimised window has a 0x0 surface, it is left out until it is restored
+		if (view.swapChainOutOfDate) {
+			if (!hasDrawableExtent(view)) continue; 
+
+			recreateSwapChain(view); 
+			view.swapChainOutOfDate = false; 
+		}
+
+		//Never wait for an image, a view that is throttled or waiting on vblank must not stall the other displays
+		uint32_t imageIndex; 
+		VkResult result = vkAcquireNextImageKHR(device, view.swapChain, 0, view.imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex); 
+
+		if (result == VK_NOT_READY || result == VK_TIMEOUT) continue; 
+		else if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+			view.swapChainOutOfDate = true; 
+			continue; 
+		}
+		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) throw std::runtime_error("failed to acquire swap chain image!"); 
+
+		//The image's command buffer may still be in use by the other frame in flight
+		if (view.imagesInFlight[imageIndex] != VK_NULL_HANDLE) vkWaitForFences(device, 1, &view.imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX); 
+		view.imagesInFlight[imageIndex] = inFlightFences[currentFrame]; 
+
+		waitSemaphores.push_back(view.imageAvailableSemaphores[currentFrame]); 
+		waitStages.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT); 
+		frameCommandBuffers.push_back(view.commandBuffers[imageIndex]); 
+		signalSemaphores.push_back(view.renderFinishedSemaphores[imageIndex]); 
+		swapChains.push_back(view.swapChain); 
+		imageIndices.push_back(imageIndex); 
+		presentViews.push_back(&view); 
+	}
+
+	if (swapChains.empty()) return 0; 
+
+	vkResetFences(device, 1, &inFlightFences[currentFrame]); 
+
+	//All views go out in one submit and one present
+	VkSubmitInfo submitInfo{}; 
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO; 
+	submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()); 
+	submitInfo.pWaitSemaphores = waitSemaphores.data(); 
+	submitInfo.pWaitDstStageMask = waitStages.data(); 
+	submitInfo.commandBufferCount = static_cast<uint32_t>(frameCommandBuffers.size()); 
+	submitInfo.pCommandBuffers = frameCommandBuffers.data(); 
+	submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()); 
+	submitInfo.pSignalSemaphores = signalSemaphores.data(); 
+
+	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) throw std::runtime_error("failed to submit draw Command Buffers!"); 
+
+	presentResults.resize(swapChains.size()); 
+
+	VkPresentInfoKHR presentInfo{}; 
+	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR; 
+	presentInfo.waitSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()); 
+	presentInfo.pWaitSemaphores = signalSemaphores.data(); 
+	presentInfo.swapchainCount = static_cast<uint32_t>(swapChains.size()); 
+	presentInfo.pSwapchains = swapChains.data(); 
+	presentInfo.pImageIndices = imageIndices.data(); 
+	presentInfo.pResults = presentResults.data(); 
+
+	vkQueuePresentKHR(presentQueue, &presentInfo); 
+
+	for (size_t it = 0; it < presentResults.size(); it++) {
+		if (presentResults[it] == VK_ERROR_OUT_OF_DATE_KHR || presentResults[it] == VK_SUBOPTIMAL_KHR) presentViews[it]->swapChainOutOfDate = true; 
+		else if (presentResults[it] != VK_SUCCESS) throw std::runtime_error("failed to present swap chain image!"); 
+	}
+
+	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT; 
+
+	return static_cast<uint32_t>(swapChains.size()); 
+}
+
 void HelloTriangleApp::mainloop() {
-	while (!glfwWindowShouldClose(window))
+	while (!views.empty())
 	{
 		glfwPollEvents(); 
+
+		//Closing a window only removes its view, the others keep running
+		for (auto it = views.begin(); it != views.end();) {
+			if (glfwWindowShouldClose(it->window)) {
+				vkDeviceWaitIdle(device); 
+				destroyView(*it); 
+				it = views.erase(it); 
+			}
+			else it++; 
+		}
+
+		//Nothing to present, e.g. every window is minimised, so wait for events instead of spinning
+		if (!views.empty() && drawFrame() == 0) glfwWaitEventsTimeout(0.01); 
 	}
+
+	vkDeviceWaitIdle(device); 
+}
+
+//Benchmark 
+
+void HelloTriangleApp::benchmark(uint32_t maxViews, uint32_t frameCount) {
+	initWindow(); 
+	initVulkan(); 
+
+	const uint32_t warmupFrames = 16; 
+
+	std::cout << "views\tframe ms\tms per view\tskipped\t(present mode " << presentModeName(views.front().presentMode) << ")\n"; 
+
+	for (uint32_t count = viewCount; count <= maxViews; count++) {
+		if (count > static_cast<uint32_t>(views.size())) addView(); 
+
+		for (uint32_t it = 0; it < warmupFrames; it++) {
+			glfwPollEvents(); 
+			drawFrame(); 
+		}
+		vkDeviceWaitIdle(device); 
+
+		//Views without a ready image are left out of a frame, so time per presented view and report how many were skipped
+		uint64_t presentedViews = 0; 
+		uint32_t frames = 0; 
+
+		auto start = std::chrono::steady_clock::now(); 
+		while (frames < frameCount) {
+			glfwPollEvents(); 
+
+			uint32_t presented = drawFrame(); 
+			if (presented > 0) frames++; 
+			presentedViews += presented; 
+		}
+		vkDeviceWaitIdle(device); 
+		auto end = std::chrono::steady_clock::now(); 
+
+		double totalMs = std::chrono::duration<double, std::milli>(end - start).count(); 
+		uint64_t skippedViews = static_cast<uint64_t>(count) * frameCount - presentedViews; 
+		std::cout << count << "\t" << totalMs / frameCount << "\t" << totalMs / presentedViews << "\t" << skippedViews << std::endl; 
+	}
+
+	cleanup(); 
 }
 
 //Cleanup 
 
 void HelloTriangleApp::cleanup() {
-	DestroyImageViews();
-	vkDestroySwapchainKHR(device, swapChain, nullptr); 
+	for (auto& view : views) destroyView(view); 
+	views.clear(); 
+
+	for (auto fence : inFlightFences) {
+		vkDestroyFence(device, fence, nullptr); 
+	}
+	vkDestroyCommandPool(device, commandPool, nullptr); 
 	vkDestroyDevice(device, nullptr);
-	vkDestroySurfaceKHR(instance, surface, nullptr); 
 	if (enableValidationLayer) DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 	vkDestroyInstance(instance, nullptr); 
 
-	glfwDestroyWindow(window); 
 	glfwTerminate(); 
 }
 
 
-int main() {
-	HelloTriangleApp app; 
+//Parses a command line count, stoul alone would wrap "-1" and ignore trailing characters
+uint32_t parseCount(const std::string& value) {
+	if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) throw std::invalid_argument("expected a count, got " + value); 
+
+	size_t pos = 0; 
+	unsigned long long count = 0; 
+	try {
+		count = std::stoull(value, &pos); 
+	}
+	catch (std::out_of_range&) {
+		throw std::out_of_range("count out of range: " + value); 
+	}
+
+	if (pos != value.size()) throw std::invalid_argument("expected a count, got " + value); 
+	if (count > std::numeric_limits<uint32_t>::max()) throw std::out_of_range("count out of range: " + value); 
+
+	return static_cast<uint32_t>(count); 
+}
+
+//Usage: 
+//	VulkanTriangle [--views N]					open N windows rendered from one device
+//	VulkanTriangle [--views S] --bench N [--frames F]	time S..N views (S defaults to 1), F frames each 
+//Headless, e.g.: VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json xvfb-run -s "-screen 0 1920x1080x24" VulkanTriangle --bench 8
+int main(int argc, char** argv) {
+	uint32_t viewCount = 1; 
+	uint32_t benchViews = 0; 
+	uint32_t benchFrames = 500; 
+	bool bench = false; 
+	bool framesGiven = false; 
+
+	try {
+		for (int it = 1; it < argc; it++) {
+			std::string arg = argv[it]; 
+
+			if (arg == "--views" && it + 1 < argc) viewCount = parseCount(argv[++it]); 
+			else if (arg == "--bench" && it + 1 < argc) {
+				benchViews = parseCount(argv[++it]); 
+				bench = true; 
+			}
+			else if (arg == "--frames" && it + 1 < argc) {
+				benchFrames = parseCount(argv[++it]); 
+				framesGiven = true; 
+			}
+			else throw std::invalid_argument("unknown argument " + arg); 
+		}
+		if (viewCount == 0 || benchFrames == 0) throw std::invalid_argument("view and frame counts must be at least 1"); 
+		if (framesGiven && !bench) throw std::invalid_argument("--frames is only used with --bench"); 
+		if (bench && benchViews == 0) throw std::invalid_argument("--bench needs at least 1 view"); 
+		if (bench && viewCount > benchViews) throw std::invalid_argument("--views must not be larger than --bench"); 
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << "\nusage: " << argv[0] << " [--views N] [--bench N [--frames F]]" << std::endl; 
+		return EXIT_FAILURE; 
+	}
+
+	//Validation would dominate the benchmark timings and is often not installed next to lavapipe. 
+	//The benchmark also prefers present modes that do not wait for vblank, otherwise every view count times at one refresh period
+	std::vector<VkPresentModeKHR> presentModePreference = { VK_PRESENT_MODE_MAILBOX_KHR }; 
+	if (bench) presentModePreference = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR }; 
+
+	HelloTriangleApp app(viewCount, !bench, presentModePreference); 
 
 	try {
-		app.run(); 
+		if (bench) app.benchmark(benchViews, benchFrames); 
+		else app.run(); 
 	}
 	catch (std::exception& e) {
 		std::cerr << e.what() << std::endl; 